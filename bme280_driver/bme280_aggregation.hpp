@@ -0,0 +1,336 @@
+/**
+ * @file	bme280_aggregation.hpp
+ * @brief	Streaming, constant-memory aggregation of BME280 measurements into compact summary records.
+ * @author	Kacper Kowalski - kacper.s.kowalski@gmail.com
+ *
+ * The building blocks are:
+ *
+ *  - BME280Decimator - averages every N consecutive measurements into a single one,
+ *  - BME280TumblingWindow - emits a summary after every N measurements and starts over,
+ *  - BME280SlidingWindow - keeps the last N measurements and provides a summary of them at any time.
+ *
+ * None of them allocates; the memory used is fixed at compile time. The statistics are computed by an accumulator
+ * policy: BME280FloatingPointAccumulator (default) or BME280FixedPointAccumulator, which accumulates scaled integers
+ * and is the better choice for MCUs without an FPU.
+ */
+#ifndef BME280_AGGREGATION_HPP
+#define BME280_AGGREGATION_HPP
+
+#include "bme280_measurement.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <limits>
+#include <optional>
+
+namespace jungles
+{
+
+struct BME280ChannelSummary
+{
+    float min;
+    float max;
+    float mean;
+    float variance; ///< Population variance.
+};
+
+struct BME280Summary
+{
+    std::chrono::milliseconds begin; ///< Timestamp of the first measurement in the window.
+    std::chrono::milliseconds end;   ///< Timestamp of the last measurement in the window.
+    uint16_t sample_count;
+    //! Number of intervals between consecutive measurements within the window, which are longer than the allowed one.
+    //! The interval preceding the first measurement of the window is not taken into account, so the count is at most
+    //! sample_count - 1.
+    uint16_t gap_count;
+    BME280ChannelSummary temperature;
+    BME280ChannelSummary pressure;
+    BME280ChannelSummary humidity;
+};
+
+/**
+ * @brief Accumulates a single channel with the Welford's algorithm.
+ */
+class BME280FloatingPointAccumulator
+{
+  public:
+    void add(float value)
+    {
+        ++count;
+        auto delta{value - mean};
+        mean += delta / count;
+        m2 += delta * (value - mean);
+        min = std::min(min, value);
+        max = std::max(max, value);
+    }
+
+    void reset()
+    {
+        *this = BME280FloatingPointAccumulator{};
+    }
+
+    float average() const
+    {
+        return mean;
+    }
+
+    BME280ChannelSummary summary() const
+    {
+        if (count == 0)
+            return {};
+        return {min, max, mean, m2 / count};
+    }
+
+  private:
+    uint32_t count{0};
+    float mean{0};
+    float m2{0};
+    float min{std::numeric_limits<float>::max()};
+    float max{std::numeric_limits<float>::lowest()};
+};
+
+/**
+ * @brief Accumulates a single channel as integers, with the resolution of 1/Scale.
+ *
+ * The values are shifted by the first accumulated one, so that the sum of squares stays small also for
+ * the pressure channel, where the absolute values are large but the spread is not.
+ */
+template<int32_t Scale = 100>
+class BME280FixedPointAccumulator
+{
+  public:
+    void add(float value)
+    {
+        auto fixed{static_cast<int32_t>(std::lround(value * Scale))};
+        if (count == 0)
+            offset = fixed;
+
+        auto shifted{static_cast<int64_t>(fixed - offset)};
+        ++count;
+        sum += shifted;
+        sum_of_squares += shifted * shifted;
+        min = std::min(min, fixed);
+        max = std::max(max, fixed);
+    }
+
+    void reset()
+    {
+        *this = BME280FixedPointAccumulator{};
+    }
+
+    float average() const
+    {
+        if (count == 0)
+            return 0;
+        return to_float(offset) + static_cast<float>(sum) / count / Scale;
+    }
+
+    BME280ChannelSummary summary() const
+    {
+        if (count == 0)
+            return {};
+        // Multiplied by count, instead of dividing by it, so that the integer part of the computation is exact.
+        auto variance_scaled{static_cast<float>(count * sum_of_squares - sum * sum)
+                             / (static_cast<float>(count) * count)};
+        return {to_float(min), to_float(max), average(), variance_scaled / (static_cast<float>(Scale) * Scale)};
+    }
+
+  private:
+    static float to_float(int32_t fixed)
+    {
+        return static_cast<float>(fixed) / Scale;
+    }
+
+    uint32_t count{0};
+    int32_t offset{0};
+    int64_t sum{0};
+    int64_t sum_of_squares{0};
+    int32_t min{std::numeric_limits<int32_t>::max()};
+    int32_t max{std::numeric_limits<int32_t>::lowest()};
+};
+
+template<typename Accumulator>
+struct BME280MeasurementAccumulator
+{
+    void add(const BME280Measurement& m)
+    {
+        temperature.add(m.temperature);
+        pressure.add(m.pressure);
+        humidity.add(m.humidity);
+    }
+
+    void reset()
+    {
+        temperature.reset();
+        pressure.reset();
+        humidity.reset();
+    }
+
+    Accumulator temperature;
+    Accumulator pressure;
+    Accumulator humidity;
+};
+
+/**
+ * @brief Reduces the sample rate by averaging every Factor consecutive measurements.
+ */
+template<unsigned Factor, typename Accumulator = BME280FloatingPointAccumulator>
+class BME280Decimator
+{
+    static_assert(Factor > 0, "Decimation factor must be positive");
+
+  public:
+    std::optional<BME280Measurement> push(const BME280Measurement& measurement)
+    {
+        accumulator.add(measurement);
+        if (++count < Factor)
+            return std::nullopt;
+
+        BME280Measurement result{
+            accumulator.temperature.average(), accumulator.pressure.average(), accumulator.humidity.average()};
+        accumulator.reset();
+        count = 0;
+        return result;
+    }
+
+  private:
+    BME280MeasurementAccumulator<Accumulator> accumulator;
+    unsigned count{0};
+};
+
+/**
+ * @brief Summarizes consecutive, non-overlapping windows of Length measurements.
+ *
+ * @param max_sample_interval Intervals between consecutive measurements longer than that are counted as gaps.
+ */
+template<unsigned Length, typename Accumulator = BME280FloatingPointAccumulator>
+class BME280TumblingWindow
+{
+    static_assert(Length > 0 && Length <= std::numeric_limits<uint16_t>::max(), "Invalid window length");
+
+  public:
+    explicit BME280TumblingWindow(std::chrono::milliseconds max_sample_interval) :
+        max_sample_interval{max_sample_interval}
+    {
+    }
+
+    std::optional<BME280Summary> push(const BME280Measurement& measurement, std::chrono::milliseconds timestamp)
+    {
+        if (sample_count == 0)
+            begin = timestamp;
+        else if (timestamp - end > max_sample_interval)
+            ++gap_count;
+        end = timestamp;
+
+        accumulator.add(measurement);
+        if (++sample_count < Length)
+            return std::nullopt;
+        return flush();
+    }
+
+    //! Returns the summary of the incomplete window, if any measurement was pushed since the last summary.
+    std::optional<BME280Summary> flush()
+    {
+        if (sample_count == 0)
+            return std::nullopt;
+
+        BME280Summary result{begin,
+                             end,
+                             sample_count,
+                             gap_count,
+                             accumulator.temperature.summary(),
+                             accumulator.pressure.summary(),
+                             accumulator.humidity.summary()};
+        accumulator.reset();
+        sample_count = 0;
+        gap_count = 0;
+        return result;
+    }
+
+  private:
+    const std::chrono::milliseconds max_sample_interval;
+    BME280MeasurementAccumulator<Accumulator> accumulator;
+    std::chrono::milliseconds begin{0};
+    std::chrono::milliseconds end{0};
+    uint16_t sample_count{0};
+    uint16_t gap_count{0};
+};
+
+/**
+ * @brief Keeps the last Length measurements and summarizes them on demand.
+ *
+ * @param max_sample_interval Intervals between consecutive measurements longer than that are counted as gaps.
+ */
+template<unsigned Length, typename Accumulator = BME280FloatingPointAccumulator>
+class BME280SlidingWindow
+{
+    static_assert(Length > 0 && Length <= std::numeric_limits<uint16_t>::max(), "Invalid window length");
+
+  public:
+    explicit BME280SlidingWindow(std::chrono::milliseconds max_sample_interval) :
+        max_sample_interval{max_sample_interval}
+    {
+    }
+
+    void push(const BME280Measurement& measurement, std::chrono::milliseconds timestamp)
+    {
+        gap_before[head] = sample_count > 0 && timestamp - timestamps[newest_index()] > max_sample_interval;
+        measurements[head] = measurement;
+        timestamps[head] = timestamp;
+        head = (head + 1) % Length;
+        if (sample_count < Length)
+            ++sample_count;
+    }
+
+    std::optional<BME280Summary> summary() const
+    {
+        if (sample_count == 0)
+            return std::nullopt;
+
+        BME280MeasurementAccumulator<Accumulator> accumulator;
+        uint16_t gap_count{0};
+        auto oldest{oldest_index()};
+        for (unsigned i{0}; i < sample_count; ++i)
+        {
+            auto index{(oldest + i) % Length};
+            accumulator.add(measurements[index]);
+            // The gap before the oldest measurement lies outside of the window.
+            if (i > 0 && gap_before[index])
+                ++gap_count;
+        }
+
+        return BME280Summary{timestamps[oldest],
+                             timestamps[newest_index()],
+                             sample_count,
+                             gap_count,
+                             accumulator.temperature.summary(),
+                             accumulator.pressure.summary(),
+                             accumulator.humidity.summary()};
+    }
+
+  private:
+    unsigned oldest_index() const
+    {
+        return (head + Length - sample_count) % Length;
+    }
+
+    unsigned newest_index() const
+    {
+        return (head + Length - 1) % Length;
+    }
+
+    const std::chrono::milliseconds max_sample_interval;
+    std::array<BME280Measurement, Length> measurements{};
+    std::array<std::chrono::milliseconds, Length> timestamps{};
+    std::bitset<Length> gap_before;
+    unsigned head{0};
+    uint16_t sample_count{0};
+};
+
+} // namespace jungles
+
+#endif /* BME280_AGGREGATION_HPP */
@@ -0,0 +1,262 @@
+/**
+ * @file	bme280_derived_metrics.cpp
+ * @brief	Implements computation of the quantities derived from BME280 measurements.
+ * @author	Kacper Kowalski - kacper.s.kowalski@gmail.com
+ */
+#include "bme280_derived_metrics.hpp"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <cstring>
+
+namespace jungles
+{
+
+// --------------------------------------------------------------------------------------------------------------------
+// Definitions of helper data types and helper structures
+// --------------------------------------------------------------------------------------------------------------------
+namespace Magnus
+{
+static inline constexpr float saturation_pressure_pa{611.2f};
+static inline constexpr float b{17.62f};
+static inline constexpr float c_deg{243.12f};
+} // namespace Magnus
+
+static inline constexpr float kelvin_offset{273.15f};
+static inline constexpr float water_vapour_gas_constant{461.5f}; // J / (kg * K)
+static inline constexpr float molar_mass_ratio{0.622f};          // water vapour to dry air
+static inline constexpr float barometric_exponent{1.0f / 5.255f};
+static inline constexpr float min_humidity{0.01f};
+
+static inline constexpr float ln_2{0.693147181f};
+static inline constexpr float log2_e{1.442695041f};
+
+struct ReferenceMath
+{
+    static float log(float x)
+    {
+        return std::log(x);
+    }
+
+    static float exp(float x)
+    {
+        return std::exp(x);
+    }
+
+    static float pow(float x, float y)
+    {
+        return std::pow(x, y);
+    }
+};
+
+/**
+ * Branchless approximations. log2() accepts positive, normal arguments only and exp2() arguments within
+ * <-126, 126>. Relative error of exp2() and absolute error of
+ * log2() are below 1e-6, i.e. comparable to the rounding error of float.
+ */
+struct FastMath
+{
+    static float log2(float x)
+    {
+        int32_t bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+        auto exponent{((bits >> 23) & 0xFF) - 127};
+
+        // Reduce the mantissa to <sqrt(2)/2, sqrt(2)), so that the series below converges quickly. Done on the bit
+        // representation, since floating point comparisons prevent vectorization when trapping math is enabled.
+        int32_t mantissa_bits{(bits & 0x007FFFFF) | 0x3F800000};
+        int32_t is_above_sqrt_2{mantissa_bits > 0x3FB504F3};
+        mantissa_bits -= is_above_sqrt_2 << 23;
+        exponent += is_above_sqrt_2;
+
+        float mantissa;
+        std::memcpy(&mantissa, &mantissa_bits, sizeof(mantissa));
+
+        // ln(m) = 2 * (t + t^3 / 3 + t^5 / 5 + t^7 / 7 + ...), where t = (m - 1) / (m + 1) and |t| < 0.172.
+        auto t{(mantissa - 1.0f) / (mantissa + 1.0f)};
+        auto t2{t * t};
+        auto series{t * (2.0f + t2 * (2.0f / 3.0f + t2 * (2.0f / 5.0f + t2 * (2.0f / 7.0f))))};
+        return static_cast<float>(exponent) + series * log2_e;
+    }
+
+    static float exp2(float x)
+    {
+        // Rounding to nearest by truncating a positive number, as it requires no branch.
+        auto integer_part{static_cast<int32_t>(x + 127.5f) - 127};
+        auto y{(x - static_cast<float>(integer_part)) * ln_2};
+
+        // e^y with |y| <= ln(2) / 2, Taylor series up to the 6th order.
+        auto fraction{
+            1.0f
+            + y
+                  * (1.0f
+                     + y
+                           * (1.0f / 2
+                              + y * (1.0f / 6 + y * (1.0f / 24 + y * (1.0f / 120 + y * (1.0f / 720))))))};
+
+        float scale;
+        int32_t scale_bits{(integer_part + 127) << 23};
+        std::memcpy(&scale, &scale_bits, sizeof(scale));
+        return fraction * scale;
+    }
+
+    static float log(float x)
+    {
+        return log2(x) * ln_2;
+    }
+
+    static float exp(float x)
+    {
+        return exp2(x * log2_e);
+    }
+
+    static float pow(float x, float y)
+    {
+        return exp2(y * log2(x));
+    }
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+// Declaration of private functions
+// --------------------------------------------------------------------------------------------------------------------
+static float at_least(float value, float min);
+
+//! Always inlined, as at -O2 GCC would otherwise keep it as a call, which prevents vectorization of the batch loop.
+template<typename Math>
+[[gnu::always_inline]] static BME280DerivedMetrics
+derive(float temperature, float pressure, float humidity, float sea_level_pressure);
+
+template<typename Math>
+static void derive(const BME280MeasurementSeries&, const BME280DerivedMetricsSeries&, float sea_level_pressure);
+
+//! The output arrays never alias the input ones, which allows the loop to be vectorized.
+template<typename Math>
+static void derive(const float* __restrict temperature,
+                   const float* __restrict pressure,
+                   const float* __restrict humidity,
+                   std::size_t size,
+                   float* __restrict altitude,
+                   float* __restrict dew_point,
+                   float* __restrict absolute_humidity,
+                   float* __restrict specific_humidity,
+                   float sea_level_pressure);
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Definition of public functions
+// ---------------------------------------------------------------------------------------------------------------------
+BME280DerivedMetrics
+derive_metrics(const BME280Measurement& measurement, float sea_level_pressure, BME280DerivationMode mode)
+{
+    auto [temperature, pressure, humidity] = measurement;
+    if (mode == BME280DerivationMode::reference)
+        return derive<ReferenceMath>(temperature, pressure, humidity, sea_level_pressure);
+    return derive<FastMath>(temperature, pressure, humidity, sea_level_pressure);
+}
+
+void derive_metrics(const BME280MeasurementSeries& input,
+                    const BME280DerivedMetricsSeries& output,
+                    float sea_level_pressure,
+                    BME280DerivationMode mode)
+{
+    if (mode == BME280DerivationMode::reference)
+        derive<ReferenceMath>(input, output, sea_level_pressure);
+    else
+        derive<FastMath>(input, output, sea_level_pressure);
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// Definition of private functions
+// --------------------------------------------------------------------------------------------------------------------
+template<typename Math>
+[[gnu::always_inline]] static inline BME280DerivedMetrics
+derive(float temperature, float pressure, float humidity, float sea_level_pressure)
+{
+    auto altitude{44330.0f * (1.0f - Math::pow(pressure / sea_level_pressure, barometric_exponent))};
+
+    auto relative_humidity{at_least(humidity, min_humidity) / 100.0f};
+    auto magnus_exponent{Magnus::b * temperature / (Magnus::c_deg + temperature)};
+    auto vapour_pressure{relative_humidity * Magnus::saturation_pressure_pa * Math::exp(magnus_exponent)};
+
+    auto gamma{Math::log(relative_humidity) + magnus_exponent};
+    auto dew_point{Magnus::c_deg * gamma / (Magnus::b - gamma)};
+
+    auto absolute_humidity{1000.0f * vapour_pressure / (water_vapour_gas_constant * (temperature + kelvin_offset))};
+    auto specific_humidity{1000.0f * molar_mass_ratio * vapour_pressure
+                           / (pressure - (1.0f - molar_mass_ratio) * vapour_pressure)};
+
+    return {altitude, dew_point, absolute_humidity, specific_humidity};
+}
+
+/**
+ * For non-negative "min" only. The bit representations of non-negative floats are ordered the same way as the signed
+ * integers, while NaNs are either negative or above the infinity, so they are clamped to "min" too.
+ */
+static inline float at_least(float value, float min)
+{
+    constexpr int32_t infinity_bits{0x7F800000};
+
+    int32_t value_bits, min_bits;
+    std::memcpy(&value_bits, &value, sizeof(value_bits));
+    std::memcpy(&min_bits, &min, sizeof(min_bits));
+    // Selected with a mask rather than a conditional, which GCC would otherwise turn into a branch.
+    int32_t is_below_min_or_nan{(value_bits < min_bits) | (value_bits > infinity_bits)};
+    int32_t mask{-is_below_min_or_nan};
+    value_bits = (value_bits & ~mask) | (min_bits & mask);
+
+    float result;
+    std::memcpy(&result, &value_bits, sizeof(result));
+    return result;
+}
+
+template<typename Math>
+static void
+derive(const BME280MeasurementSeries& input, const BME280DerivedMetricsSeries& output, float sea_level_pressure)
+{
+    derive<Math>(input.temperature,
+                 input.pressure,
+                 input.humidity,
+                 input.size,
+                 output.altitude,
+                 output.dew_point,
+                 output.absolute_humidity,
+                 output.specific_humidity,
+                 sea_level_pressure);
+}
+
+template<typename Math>
+static void derive(const float* __restrict temperature,
+                   const float* __restrict pressure,
+                   const float* __restrict humidity,
+                   std::size_t size,
+                   float* __restrict altitude,
+                   float* __restrict dew_point,
+                   float* __restrict absolute_humidity,
+                   float* __restrict specific_humidity,
+                   float sea_level_pressure)
+{
+    // At -O2 GCC vectorizes only the loops which need no scalar remainder, so the bulk of the series is processed
+    // in blocks of a fixed size, which is a multiple of the vector width.
+    constexpr std::size_t block_size{16};
+    std::size_t i{0};
+    for (; i + block_size <= size; i += block_size)
+        for (std::size_t j{i}; j < i + block_size; ++j)
+        {
+            auto result{derive<Math>(temperature[j], pressure[j], humidity[j], sea_level_pressure)};
+            altitude[j] = result.altitude;
+            dew_point[j] = result.dew_point;
+            absolute_humidity[j] = result.absolute_humidity;
+            specific_humidity[j] = result.specific_humidity;
+        }
+
+    for (; i < size; ++i)
+    {
+        auto result{derive<Math>(temperature[i], pressure[i], humidity[i], sea_level_pressure)};
+        altitude[i] = result.altitude;
+        dew_point[i] = result.dew_point;
+        absolute_humidity[i] = result.absolute_humidity;
+        specific_humidity[i] = result.specific_humidity;
+    }
+}
+
+} // namespace jungles
@@ -0,0 +1,85 @@
+/**
+ * @file	bme280_derived_metrics.hpp
+ * @brief	Computes quantities derived from BME280 measurements: altitude, dew point, absolute and specific humidity.
+ * @author	Kacper Kowalski - kacper.s.kowalski@gmail.com
+ *
+ * The saturation vapour pressure is obtained from the Magnus formula with the Sonntag (1990) coefficients. The
+ * altitude is the one of the International Standard Atmosphere for the given sea level pressure.
+ *
+ * Two modes are available:
+ *
+ *  - BME280DerivationMode::reference - uses the standard library. It is the default for both variants, so that the
+ *    same measurements always give the same results,
+ *  - BME280DerivationMode::fast - log2() and exp2() are replaced with branchless polynomial approximations, so that
+ *    the batch variant is vectorized by the compiler. It pays off only for the batch variant, compiled with -O2 or
+ *    higher (GCC 12 or newer vectorizes at -O2), where it is about three times faster. Without vectorization, e.g. at
+ *    -Os, or for a single measurement, it is slower than the reference mode.
+ *
+ * Maximum difference between the modes for temperature in <-40, 85> deg C, pressure in <30, 110> kPa and humidity
+ * in <1, 100> %RH:
+ *
+ *  - altitude: 0.01 m,
+ *  - dew point: 0.001 deg C,
+ *  - absolute humidity: 0.001 g/m3,
+ *  - specific humidity: 0.001 %, relative.
+ */
+#ifndef BME280_DERIVED_METRICS_HPP
+#define BME280_DERIVED_METRICS_HPP
+
+#include "bme280_measurement.hpp"
+
+#include <cstddef>
+
+namespace jungles
+{
+
+struct BME280DerivedMetrics
+{
+    float altitude;          ///< Meters above the sea level.
+    float dew_point;         ///< Degrees Celsius.
+    float absolute_humidity; ///< Grams of water vapour per cubic meter.
+    float specific_humidity; ///< Grams of water vapour per kilogram of moist air.
+};
+
+//! Measurements in the structure-of-arrays layout. All the arrays shall have "size" elements.
+struct BME280MeasurementSeries
+{
+    const float* temperature;
+    const float* pressure;
+    const float* humidity;
+    std::size_t size;
+};
+
+//! Output arrays for BME280MeasurementSeries. Each of them shall have at least as many elements as the input.
+struct BME280DerivedMetricsSeries
+{
+    float* altitude;
+    float* dew_point;
+    float* absolute_humidity;
+    float* specific_humidity;
+};
+
+enum class BME280DerivationMode
+{
+    fast,
+    reference
+};
+
+static inline constexpr float standard_sea_level_pressure{101325.0f};
+
+/**
+ * @brief Humidity below 0.01 %RH, or NaN, is clamped to that value, as the dew point is undefined for completely dry
+ * air. NaN temperature or pressure give NaN results in the reference mode and unspecified ones in the fast mode.
+ */
+BME280DerivedMetrics derive_metrics(const BME280Measurement&,
+                                    float sea_level_pressure = standard_sea_level_pressure,
+                                    BME280DerivationMode = BME280DerivationMode::reference);
+
+void derive_metrics(const BME280MeasurementSeries&,
+                    const BME280DerivedMetricsSeries&,
+                    float sea_level_pressure = standard_sea_level_pressure,
+                    BME280DerivationMode = BME280DerivationMode::reference);
+
+} // namespace jungles
+
+#endif /* BME280_DERIVED_METRICS_HPP */
@@ -26,12 +26,12 @@ static auto make_poller(BME280Driver::MillisecondDelayer& millisecond_delayer)
     }};
 }
 
-BME280Driver::BME280Driver(I2CMaster& i2c, MillisecondDelayer millisecond_delayer) :
+BME280Driver::BME280Driver(I2CMaster& i2c, MillisecondDelayer millisecond_delayer, BME280Settings settings) :
     bme280_i2c_io{I2CMaster::IO(i2c, BME280::address)},
     millisecond_delayer{std::move(millisecond_delayer)},
-    callibration_data{get_callibration_data()}
+    compensation_parameters{get_compensation_parameters()}
 {
-    configure_sensor();
+    configure(settings);
 }
 
 BME280Measurement BME280Driver::read()
@@ -39,42 +39,52 @@ BME280Measurement BME280Driver::read()
     start_one_shot_measurement();
     wait_measurement_finished();
     auto raw_data{get_raw_data()};
-    auto result{BME280::to_real_values(callibration_data, raw_data)};
-    return {result.temperature, result.pressure, result.humidity};
+    return BME280::compensate(compensation_parameters, raw_data);
 }
 
-BME280::CallibrationData BME280Driver::get_callibration_data()
+BME280::CompensationParameters BME280Driver::get_compensation_parameters()
 {
     wait_device_accessible();
 
-    BME280::CallibrationData callib_data{};
+    BME280::CallibrationFirstPartBytes first_part{};
     read_from_device(to_u_type(BME280::RegisterAddress::callibration_first_part_beg),
-                     reinterpret_cast<uint8_t*>(callib_data.mapped_region),
-                     sizeof(callib_data.mapped_region));
+                     first_part.data(),
+                     first_part.size());
 
-    BME280::CallibrationDataSecondPart second_part{};
+    BME280::CallibrationSecondPartBytes second_part{};
     read_from_device(to_u_type(BME280::RegisterAddress::callibration_second_part_beg),
-                     reinterpret_cast<uint8_t*>(second_part.mapped_region),
-                     sizeof(second_part.mapped_region));
+                     second_part.data(),
+                     second_part.size());
 
-    callib_data.dig_H2 = second_part.dig_H2;
-    callib_data.dig_H3 = second_part.dig_H3;
-    // Because of that we couldn't map this memory region to BME280_callibration_data union.
-    callib_data.dig_H4 = second_part.dig_H4_msb << 4 | (second_part.dig_H4_lsb_H5_lsb & 0x0F);
-    callib_data.dig_H5 = second_part.dig_H5_msb << 4 | (second_part.dig_H4_lsb_H5_lsb >> 4);
-    callib_data.dig_H6 = second_part.dig_H6;
-
-    return callib_data;
+    return BME280::decode_compensation_parameters(first_part, second_part);
 }
 
-void BME280Driver::configure_sensor()
+void BME280Driver::configure(const BME280Settings& settings)
 {
+    // Filter settings are only guaranteed to be applied in sleep mode, which the sensor is in between the forced
+    // measurements. Changes to "ctrl_hum" become effective only after writing to "ctrl_meas".
+    bme280_i2c_io.write_byte(to_u_type(BME280::RegisterAddress::config),
+                             BME280::Configuration::filter_coefficient(to_u_type(settings.filter)));
+
     bme280_i2c_io.write_byte(to_u_type(BME280::RegisterAddress::control_humidity),
-                             BME280::ControlHumidity::oversampling_8);
+                             BME280::ControlHumidity::humidity_oversampling(to_u_type(settings.humidity_oversampling)));
+
+    bme280_i2c_io.write_byte(
+        to_u_type(BME280::RegisterAddress::control_measurement),
+        BME280::ControlMeasurement::temperature_oversampling(to_u_type(settings.temperature_oversampling))
+            | BME280::ControlMeasurement::pressure_oversampling(to_u_type(settings.pressure_oversampling)));
+
+    current_settings = settings;
+}
 
-    bme280_i2c_io.write_byte(to_u_type(BME280::RegisterAddress::control_measurement),
-                             BME280::ControlMeasurement::temperature_oversampling_8
-                                 | BME280::ControlMeasurement::pressure_oversampling_8);
+const BME280Settings& BME280Driver::settings() const
+{
+    return current_settings;
+}
+
+std::chrono::microseconds BME280Driver::measurement_time() const
+{
+    return jungles::measurement_time(current_settings);
 }
 
 void BME280Driver::wait_device_accessible()
@@ -105,6 +115,10 @@ void BME280Driver::start_one_shot_measurement()
 
 void BME280Driver::wait_measurement_finished()
 {
+    // With the highest oversampling the measurement takes longer than the poller timeout, so don't start polling
+    // before the measurement is expected to be finished.
+    millisecond_delayer(std::chrono::ceil<std::chrono::milliseconds>(measurement_time()));
+
     auto poller{make_poller<1, 100>(millisecond_delayer)};
 
     auto is_no_timeout{poller.poll([&]() {
@@ -120,12 +134,10 @@ void BME280Driver::wait_measurement_finished()
         throw Error{"Error waiting for BME280 measurement finished"};
 }
 
-BME280::RawData BME280Driver::get_raw_data()
+BME280::RawDataBytes BME280Driver::get_raw_data()
 {
-    BME280::RawData result{};
-    auto raw_data_size{sizeof(result.mapped_region)};
-    auto raw_data{bme280_i2c_io.read(to_u_type(BME280::RegisterAddress::data_beg), raw_data_size)};
-    std::copy(std::begin(raw_data), std::end(raw_data), result.mapped_region);
+    BME280::RawDataBytes result{};
+    read_from_device(to_u_type(BME280::RegisterAddress::data_beg), result.data(), result.size());
     return result;
 }
 
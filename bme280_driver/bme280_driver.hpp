@@ -10,9 +10,10 @@
 
 #include "i2c_master.hpp"
 
-#include "bme280_conversion.hpp"
+#include "bme280_compensation.hpp"
 #include "bme280_measurement.hpp"
 #include "bme280_registers.hpp"
+#include "bme280_settings.hpp"
 
 #include <chrono>
 #include <exception>
@@ -26,10 +27,15 @@ class BME280Driver
   public:
     using MillisecondDelayer = std::function<void(std::chrono::milliseconds)>;
 
-    explicit BME280Driver(I2CMaster&, MillisecondDelayer);
+    explicit BME280Driver(I2CMaster&, MillisecondDelayer, BME280Settings = {});
 
     BME280Measurement read();
 
+    //! Reprograms oversampling and the IIR filter. Takes effect from the next measurement.
+    void configure(const BME280Settings&);
+    const BME280Settings& settings() const;
+    std::chrono::microseconds measurement_time() const;
+
     struct Error : std::exception
     {
         Error(const char* message) : message{message}
@@ -45,17 +51,17 @@ class BME280Driver
     };
 
   private:
-    BME280::CallibrationData get_callibration_data();
-    void configure_sensor();
+    BME280::CompensationParameters get_compensation_parameters();
     void wait_device_accessible();
     void start_one_shot_measurement();
     void wait_measurement_finished();
-    BME280::RawData get_raw_data();
+    BME280::RawDataBytes get_raw_data();
     void read_from_device(unsigned char register_address, unsigned char* data, unsigned length);
 
     I2CMaster::IO bme280_i2c_io;
     MillisecondDelayer millisecond_delayer;
-    BME280::CallibrationData callibration_data;
+    BME280::CompensationParameters compensation_parameters;
+    BME280Settings current_settings;
 };
 
 } // namespace jungles
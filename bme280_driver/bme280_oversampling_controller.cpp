@@ -0,0 +1,223 @@
+/**
+ * @file	bme280_oversampling_controller.cpp
+ * @brief	Implements the adaptive oversampling controller.
+ * @author	Kacper Kowalski - kacper.s.kowalski@gmail.com
+ */
+#include "bme280_oversampling_controller.hpp"
+
+#include <cmath>
+#include <type_traits>
+
+namespace jungles
+{
+
+template<typename E>
+static E next(E e)
+{
+    return static_cast<E>(static_cast<std::underlying_type_t<E>>(e) + 1);
+}
+
+template<typename E>
+static E previous(E e)
+{
+    return static_cast<E>(static_cast<std::underlying_type_t<E>>(e) - 1);
+}
+
+static void decrease(BME280Oversampling& oversampling)
+{
+    if (oversampling != BME280Oversampling::x1)
+        oversampling = previous(oversampling);
+}
+
+static unsigned to_coefficient(BME280Filter filter)
+{
+    return 1u << static_cast<unsigned>(filter);
+}
+
+/**
+ * The filter computes y[n] = y[n - 1] + (x[n] - y[n - 1]) / c, so white input noise of variance s^2 gives output
+ * noise of variance s^2 / (2c - 1).
+ */
+static float filtered_variance_gain(unsigned filter_coefficient)
+{
+    return 1.0f / (2 * filter_coefficient - 1);
+}
+
+BME280OversamplingController::BME280OversamplingController(BME280Settings initial_settings) :
+    BME280OversamplingController{initial_settings, Config{}}
+{
+}
+
+BME280OversamplingController::BME280OversamplingController(BME280Settings initial_settings, Config config) :
+    config{config}, current_settings{initial_settings}
+{
+    fit_within_latency_budget();
+}
+
+std::optional<BME280Settings> BME280OversamplingController::update(const BME280Measurement& measurement)
+{
+    // The measurement was made with the settings which are yet to be changed, so it doesn't tell anything.
+    if (is_change_pending)
+    {
+        is_change_pending = false;
+        return current_settings;
+    }
+
+    auto is_first{samples_in_block == 0};
+    temperature.add(measurement.temperature, is_first);
+    pressure.add(measurement.pressure, is_first);
+    humidity.add(measurement.humidity, is_first);
+
+    // The first measurement of the block gives no difference, so the block is one measurement longer.
+    if (++samples_in_block <= config.estimation_samples)
+        return std::nullopt;
+
+    auto filter_coefficient{to_coefficient(current_settings.filter)};
+    auto is_filter_on{current_settings.filter != BME280Filter::off};
+    auto filter_decrease_ratio{is_filter_on ? filtered_variance_gain(filter_coefficient / 2)
+                                                  / filtered_variance_gain(filter_coefficient)
+                                            : 2.0f};
+
+    // Halving the number of samples doubles the variance of the noise.
+    auto temperature_step{temperature_decision.confirm(
+        choose_step(temperature.variance(filter_coefficient), config.temperature_noise, 2.0f), config.confirmations)};
+    auto pressure_step{pressure_decision.confirm(
+        choose_step(pressure.variance(filter_coefficient), config.pressure_noise, filter_decrease_ratio),
+        config.confirmations)};
+    auto humidity_step{humidity_decision.confirm(choose_step(humidity.variance(1), config.humidity_noise, 2.0f),
+                                                 config.confirmations)};
+
+    auto candidate{current_settings};
+
+    if (temperature_step == Step::down)
+        decrease(candidate.temperature_oversampling);
+    if (pressure_step == Step::down)
+    {
+        if (is_filter_on)
+            candidate.filter = previous(candidate.filter);
+        else
+            decrease(candidate.pressure_oversampling);
+    }
+    if (humidity_step == Step::down)
+        decrease(candidate.humidity_oversampling);
+
+    auto increase_within_latency_budget{[&](BME280Oversampling BME280Settings::*oversampling) {
+        auto increased{candidate};
+        if (increased.*oversampling == BME280Oversampling::x16)
+            return false;
+        increased.*oversampling = next(increased.*oversampling);
+        if (jungles::measurement_time(increased) > config.max_measurement_time)
+            return false;
+        candidate = increased;
+        return true;
+    }};
+
+    // Pressure goes first, as it is the channel which benefits most from oversampling.
+    if (pressure_step == Step::up)
+    {
+        auto is_increased{increase_within_latency_budget(&BME280Settings::pressure_oversampling)};
+        if (!is_increased && candidate.filter < config.max_filter)
+            candidate.filter = next(candidate.filter);
+    }
+    if (temperature_step == Step::up)
+        increase_within_latency_budget(&BME280Settings::temperature_oversampling);
+    if (humidity_step == Step::up)
+        increase_within_latency_budget(&BME280Settings::humidity_oversampling);
+
+    start_estimation();
+    if (candidate == current_settings)
+        return std::nullopt;
+
+    // The decisions were made for the previous settings.
+    temperature_decision = {};
+    pressure_decision = {};
+    humidity_decision = {};
+    current_settings = candidate;
+    return current_settings;
+}
+
+const BME280Settings& BME280OversamplingController::settings() const
+{
+    return current_settings;
+}
+
+std::chrono::microseconds BME280OversamplingController::measurement_time() const
+{
+    return jungles::measurement_time(current_settings);
+}
+
+BME280OversamplingController::Step BME280OversamplingController::choose_step(
+    float noise_variance, float budget, float variance_ratio_after_decrease) const
+{
+    auto noise{std::sqrt(noise_variance)};
+    if (noise > budget * (1 + config.hysteresis))
+        return Step::up;
+
+    auto noise_after_decrease{std::sqrt(noise_variance * variance_ratio_after_decrease)};
+    if (noise_after_decrease < budget * (1 - config.hysteresis))
+        return Step::down;
+
+    return Step::none;
+}
+
+void BME280OversamplingController::start_estimation()
+{
+    temperature = {};
+    pressure = {};
+    humidity = {};
+    samples_in_block = 0;
+}
+
+void BME280OversamplingController::fit_within_latency_budget()
+{
+    // Pressure goes last, as it is the channel which benefits most from oversampling.
+    BME280Oversampling BME280Settings::*channels[]{&BME280Settings::humidity_oversampling,
+                                                   &BME280Settings::temperature_oversampling,
+                                                   &BME280Settings::pressure_oversampling};
+
+    while (jungles::measurement_time(current_settings) > config.max_measurement_time)
+    {
+        auto highest{channels[0]};
+        for (auto channel : channels)
+            if (current_settings.*channel > current_settings.*highest)
+                highest = channel;
+
+        if (current_settings.*highest == BME280Oversampling::x1)
+            return;
+
+        current_settings.*highest = previous(current_settings.*highest);
+        is_change_pending = true;
+    }
+}
+
+void BME280OversamplingController::NoiseEstimator::add(float value, bool is_first)
+{
+    if (!is_first)
+    {
+        auto difference{value - previous};
+        sum_of_squared_differences += difference * difference;
+        ++count;
+    }
+    previous = value;
+}
+
+float BME280OversamplingController::NoiseEstimator::variance(unsigned filter_coefficient) const
+{
+    if (count == 0)
+        return 0;
+
+    // Variance of the difference of two independent samples is twice the variance of the noise. The filter makes
+    // the consecutive outputs correlated: the differences shrink by the factor 1 / c relative to the output noise.
+    auto difference_variance{sum_of_squared_differences / count / 2};
+    return difference_variance * filter_coefficient;
+}
+
+BME280OversamplingController::Step BME280OversamplingController::Decision::confirm(Step new_step,
+                                                                                    unsigned confirmations)
+{
+    streak = new_step == step ? streak + 1 : 1;
+    step = new_step;
+    return streak >= confirmations ? step : Step::none;
+}
+
+} // namespace jungles
@@ -0,0 +1,120 @@
+/**
+ * @file	bme280_oversampling_controller.hpp
+ * @brief	Adapts BME280 oversampling and IIR filter to the observed signal noise.
+ * @author	Kacper Kowalski - kacper.s.kowalski@gmail.com
+ */
+#ifndef BME280_OVERSAMPLING_CONTROLLER_HPP
+#define BME280_OVERSAMPLING_CONTROLLER_HPP
+
+#include "bme280_measurement.hpp"
+#include "bme280_settings.hpp"
+
+#include <chrono>
+#include <optional>
+
+namespace jungles
+{
+
+/**
+ * @brief Chooses the lowest oversampling which keeps the noise of each channel within the budget.
+ *
+ * The short-term noise of each channel is estimated from the differences between consecutive measurements, so that
+ * slow changes of the conditions are not taken as noise. The estimate is averaged over a block of measurements and
+ * corrected for the correlation introduced by the IIR filter, which applies to temperature and pressure.
+ *
+ * Once the noise exceeds the budget the oversampling of the channel is increased. If the pressure oversampling can't
+ * be increased, because it is already x16 or because of the latency budget, the IIR filter coefficient is increased
+ * instead. The oversampling is decreased when the noise expected afterwards is still within the budget; for pressure the
+ * filter coefficient is decreased first. A channel is changed only when the same decision is made for several
+ * consecutive blocks.
+ *
+ * The measurement time never exceeds the latency budget. Initial settings which exceed it are lowered already by the
+ * constructor, the highest oversampling first, and are returned by the first call to update(). A budget below the
+ * measurement time at x1 oversampling can't be met; all the channels are kept at x1 then.
+ *
+ * Usage:
+ *
+ *      auto measurement{driver.read()};
+ *      if (auto new_settings{controller.update(measurement)}; new_settings)
+ *          driver.configure(*new_settings);
+ */
+class BME280OversamplingController
+{
+  public:
+    struct Config
+    {
+        //! Allowed standard deviation of the temperature noise, in degrees Celsius.
+        float temperature_noise{0.01};
+        //! Allowed standard deviation of the pressure noise, in Pascals.
+        float pressure_noise{2.0};
+        //! Allowed standard deviation of the humidity noise, in %RH.
+        float humidity_noise{0.05};
+
+        std::chrono::microseconds max_measurement_time{std::chrono::milliseconds{60}};
+        //! The IIR filter delays the response to the step changes, so its coefficient is limited separately.
+        BME280Filter max_filter{BME280Filter::coefficient_4};
+
+        //! Relative margin around the budget, within which the settings are not changed.
+        float hysteresis{0.3};
+        //! Number of measurements over which the noise is estimated for a single decision.
+        unsigned estimation_samples{32};
+        //! Number of consecutive, equal decisions needed to change the settings of a channel.
+        unsigned confirmations{2};
+    };
+
+    explicit BME280OversamplingController(BME280Settings initial_settings);
+    BME280OversamplingController(BME280Settings initial_settings, Config config);
+
+    //! Returns new settings when they shall be applied to the sensor.
+    std::optional<BME280Settings> update(const BME280Measurement&);
+
+    const BME280Settings& settings() const;
+    std::chrono::microseconds measurement_time() const;
+
+  private:
+    struct NoiseEstimator
+    {
+        void add(float value, bool is_first);
+        //! @param filter_coefficient 1 when the output is not filtered.
+        float variance(unsigned filter_coefficient) const;
+
+        float previous{0};
+        float sum_of_squared_differences{0};
+        unsigned count{0};
+    };
+
+    enum class Step
+    {
+        down,
+        none,
+        up
+    };
+
+    struct Decision
+    {
+        //! Returns the step once it has been confirmed enough times in a row.
+        Step confirm(Step, unsigned confirmations);
+
+        Step step{Step::none};
+        unsigned streak{0};
+    };
+
+    Step choose_step(float noise_variance, float budget, float variance_ratio_after_decrease) const;
+    void start_estimation();
+    void fit_within_latency_budget();
+
+    Config config;
+    BME280Settings current_settings;
+    NoiseEstimator temperature;
+    NoiseEstimator pressure;
+    NoiseEstimator humidity;
+    Decision temperature_decision;
+    Decision pressure_decision;
+    Decision humidity_decision;
+    unsigned samples_in_block{0};
+    bool is_change_pending{false};
+};
+
+} // namespace jungles
+
+#endif /* BME280_OVERSAMPLING_CONTROLLER_HPP */
@@ -0,0 +1,73 @@
+/**
+ * @file	bme280_settings.hpp
+ * @brief	Defines the oversampling and IIR filter settings of BME280.
+ * @author	Kacper Kowalski - kacper.s.kowalski@gmail.com
+ */
+#ifndef BME280_SETTINGS_HPP
+#define BME280_SETTINGS_HPP
+
+#include <chrono>
+#include <cinttypes>
+
+namespace jungles
+{
+
+//! The values are the ones written to the osrs_t, osrs_p and osrs_h register fields.
+enum class BME280Oversampling : uint8_t
+{
+    x1 = 1,
+    x2 = 2,
+    x4 = 3,
+    x8 = 4,
+    x16 = 5
+};
+
+//! The values are the ones written to the filter field of the config register.
+enum class BME280Filter : uint8_t
+{
+    off = 0,
+    coefficient_2 = 1,
+    coefficient_4 = 2,
+    coefficient_8 = 3,
+    coefficient_16 = 4
+};
+
+struct BME280Settings
+{
+    BME280Oversampling temperature_oversampling{BME280Oversampling::x8};
+    BME280Oversampling pressure_oversampling{BME280Oversampling::x8};
+    BME280Oversampling humidity_oversampling{BME280Oversampling::x8};
+    BME280Filter filter{BME280Filter::off};
+
+    bool operator==(const BME280Settings& other) const
+    {
+        return temperature_oversampling == other.temperature_oversampling
+               && pressure_oversampling == other.pressure_oversampling
+               && humidity_oversampling == other.humidity_oversampling && filter == other.filter;
+    }
+
+    bool operator!=(const BME280Settings& other) const
+    {
+        return !(*this == other);
+    }
+};
+
+constexpr unsigned to_sample_count(BME280Oversampling oversampling)
+{
+    return 1u << (static_cast<unsigned>(oversampling) - 1);
+}
+
+/**
+ * @brief Maximum measurement time in forced mode, as given in the chapter 9.1 of the datasheet.
+ */
+constexpr std::chrono::microseconds measurement_time(const BME280Settings& settings)
+{
+    auto temperature_us{2300 * to_sample_count(settings.temperature_oversampling)};
+    auto pressure_us{2300 * to_sample_count(settings.pressure_oversampling) + 575};
+    auto humidity_us{2300 * to_sample_count(settings.humidity_oversampling) + 575};
+    return std::chrono::microseconds{1250 + temperature_us + pressure_us + humidity_us};
+}
+
+} // namespace jungles
+
+#endif /* BME280_SETTINGS_HPP */
@@ -0,0 +1,213 @@
+/**
+ * @file bme280_compensation.hpp
+ * @author Kacper Kowalski (kacper.s.kowalski@gmail.com)
+ * @brief Header-only, constexpr implementation of the BME280 compensation formulas.
+ * @date 2026-10-18
+ *
+ * The calibration and measurement registers are decoded byte by byte, instead of being mapped onto packed unions,
+ * so that everything here can be evaluated at compile time and fully inlined into the callers.
+ */
+#ifndef __BME280_COMPENSATION_HPP__
+#define __BME280_COMPENSATION_HPP__
+
+#include <array>
+#include <cinttypes>
+
+#include "../bme280_measurement.hpp"
+
+namespace jungles
+{
+
+namespace BME280
+{
+
+static inline constexpr unsigned callibration_first_part_size{26};
+static inline constexpr unsigned callibration_second_part_size{7};
+static inline constexpr unsigned raw_data_size{8};
+
+using CallibrationFirstPartBytes = std::array<uint8_t, callibration_first_part_size>;
+using CallibrationSecondPartBytes = std::array<uint8_t, callibration_second_part_size>;
+using RawDataBytes = std::array<uint8_t, raw_data_size>;
+
+struct CompensationParameters
+{
+    uint16_t dig_T1;
+    int16_t dig_T2;
+    int16_t dig_T3;
+
+    uint16_t dig_P1;
+    int16_t dig_P2;
+    int16_t dig_P3;
+    int16_t dig_P4;
+    int16_t dig_P5;
+    int16_t dig_P6;
+    int16_t dig_P7;
+    int16_t dig_P8;
+    int16_t dig_P9;
+
+    uint8_t dig_H1;
+    int16_t dig_H2;
+    uint8_t dig_H3;
+    int16_t dig_H4;
+    int16_t dig_H5;
+    int8_t dig_H6;
+};
+
+//! Values read from the ADCs: 20-bit temperature and pressure, 16-bit humidity.
+struct AdcValues
+{
+    int32_t temperature;
+    int32_t pressure;
+    int32_t humidity;
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+// Decoding of the registers
+// --------------------------------------------------------------------------------------------------------------------
+namespace detail
+{
+
+constexpr uint16_t to_u16(uint8_t lsb, uint8_t msb)
+{
+    return static_cast<uint16_t>(msb << 8 | lsb);
+}
+
+constexpr int16_t to_s16(uint8_t lsb, uint8_t msb)
+{
+    return static_cast<int16_t>(to_u16(lsb, msb));
+}
+
+} // namespace detail
+
+/**
+ * @param first_part Registers 0x88 to 0xA1.
+ * @param second_part Registers 0xE1 to 0xE7.
+ */
+constexpr CompensationParameters decode_compensation_parameters(const CallibrationFirstPartBytes& first_part,
+                                                                const CallibrationSecondPartBytes& second_part)
+{
+    using detail::to_s16;
+    using detail::to_u16;
+
+    const auto& b{first_part};
+    const auto& e{second_part};
+
+    // dig_H4 and dig_H5 share the register 0xE5, each one takes its half.
+    auto dig_H4{static_cast<int16_t>(static_cast<int8_t>(e[3]) * 16 | (e[4] & 0x0F))};
+    auto dig_H5{static_cast<int16_t>(static_cast<int8_t>(e[5]) * 16 | (e[4] >> 4))};
+
+    return {to_u16(b[0], b[1]),
+            to_s16(b[2], b[3]),
+            to_s16(b[4], b[5]),
+            to_u16(b[6], b[7]),
+            to_s16(b[8], b[9]),
+            to_s16(b[10], b[11]),
+            to_s16(b[12], b[13]),
+            to_s16(b[14], b[15]),
+            to_s16(b[16], b[17]),
+            to_s16(b[18], b[19]),
+            to_s16(b[20], b[21]),
+            to_s16(b[22], b[23]),
+            b[25],
+            to_s16(e[0], e[1]),
+            e[2],
+            dig_H4,
+            dig_H5,
+            static_cast<int8_t>(e[6])};
+}
+
+//! @param registers Registers 0xF7 to 0xFE.
+constexpr AdcValues decode_adc_values(const RawDataBytes& registers)
+{
+    const auto& r{registers};
+    return {r[3] << 12 | r[4] << 4 | r[5] >> 4, r[0] << 12 | r[1] << 4 | r[2] >> 4, r[6] << 8 | r[7]};
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// Compensation formulas, as given in the chapter 4.2.3 of the datasheet.
+//
+// Left shifts of signed values are written as multiplications, because shifting a negative value left is not allowed
+// in constant expressions.
+// --------------------------------------------------------------------------------------------------------------------
+constexpr int32_t calculate_fine_temperature(int32_t adc_T, const CompensationParameters& c)
+{
+    int32_t var1{(((adc_T >> 3) - (static_cast<int32_t>(c.dig_T1) << 1)) * static_cast<int32_t>(c.dig_T2)) >> 11};
+
+    int32_t var2{(((((adc_T >> 4) - static_cast<int32_t>(c.dig_T1)) * ((adc_T >> 4) - static_cast<int32_t>(c.dig_T1)))
+                   >> 12)
+                  * static_cast<int32_t>(c.dig_T3))
+                 >> 14};
+
+    return var1 + var2;
+}
+
+constexpr float compensate_temperature(int32_t t_fine)
+{
+    float T = (t_fine * 5 + 128) >> 8;
+    return T / 100.0;
+}
+
+constexpr float compensate_pressure(int32_t adc_P, int32_t t_fine, const CompensationParameters& c)
+{
+    int64_t var1{static_cast<int64_t>(t_fine) - 128000};
+    int64_t var2{var1 * var1 * static_cast<int64_t>(c.dig_P6)};
+    var2 = var2 + var1 * static_cast<int64_t>(c.dig_P5) * (int64_t{1} << 17);
+    var2 = var2 + static_cast<int64_t>(c.dig_P4) * (int64_t{1} << 35);
+    var1 = ((var1 * var1 * static_cast<int64_t>(c.dig_P3)) >> 8)
+           + var1 * static_cast<int64_t>(c.dig_P2) * (int64_t{1} << 12);
+    var1 = ((int64_t{1} << 47) + var1) * static_cast<int64_t>(c.dig_P1) >> 33;
+
+    if (var1 == 0)
+        return 0.0; // avoid exception caused by division by zero
+
+    int64_t p{1048576 - adc_P};
+    p = ((p * (int64_t{1} << 31) - var2) * 3125) / var1;
+    var1 = (static_cast<int64_t>(c.dig_P9) * (p >> 13) * (p >> 13)) >> 25;
+    var2 = (static_cast<int64_t>(c.dig_P8) * p) >> 19;
+
+    p = ((p + var1 + var2) >> 8) + static_cast<int64_t>(c.dig_P7) * 16;
+    return static_cast<float>(p) / 256.0;
+}
+
+constexpr float compensate_humidity(int32_t adc_H, int32_t t_fine, const CompensationParameters& c)
+{
+    int32_t v_x1_u32r{t_fine - 76800};
+
+    v_x1_u32r = ((((adc_H << 14) - static_cast<int32_t>(c.dig_H4) * (1 << 20)
+                   - static_cast<int32_t>(c.dig_H5) * v_x1_u32r)
+                  + 16384)
+                 >> 15)
+                * (((((((v_x1_u32r * static_cast<int32_t>(c.dig_H6)) >> 10)
+                       * (((v_x1_u32r * static_cast<int32_t>(c.dig_H3)) >> 11) + 32768))
+                      >> 10)
+                     + 2097152)
+                        * static_cast<int32_t>(c.dig_H2)
+                    + 8192)
+                   >> 14);
+
+    v_x1_u32r = v_x1_u32r - (((((v_x1_u32r >> 15) * (v_x1_u32r >> 15)) >> 7) * static_cast<int32_t>(c.dig_H1)) >> 4);
+
+    v_x1_u32r = (v_x1_u32r < 0) ? 0 : v_x1_u32r;
+    v_x1_u32r = (v_x1_u32r > 419430400) ? 419430400 : v_x1_u32r;
+    float h = (v_x1_u32r >> 12);
+    return h / 1024.0;
+}
+
+constexpr BME280Measurement compensate(const CompensationParameters& parameters, const AdcValues& adc)
+{
+    auto t_fine{calculate_fine_temperature(adc.temperature, parameters)};
+    return {compensate_temperature(t_fine),
+            compensate_pressure(adc.pressure, t_fine, parameters),
+            compensate_humidity(adc.humidity, t_fine, parameters)};
+}
+
+constexpr BME280Measurement compensate(const CompensationParameters& parameters, const RawDataBytes& registers)
+{
+    return compensate(parameters, decode_adc_values(registers));
+}
+
+} // namespace BME280
+
+} // namespace jungles
+
+#endif // __BME280_COMPENSATION_HPP__
@@ -60,7 +60,12 @@ enum : uint8_t
     oversampling_8 = 4,
     oversampling_16 = 5
 };
+
+constexpr uint8_t humidity_oversampling(uint8_t field)
+{
+    return field;
 }
+} // namespace ControlHumidity
 
 namespace ControlMeasurement
 {
@@ -84,8 +89,21 @@ enum : uint8_t
     forced_mode = 0b00000001,
     normal_mode = 0b00000011,
 };
+
+constexpr uint8_t temperature_oversampling(uint8_t field)
+{
+    return static_cast<uint8_t>(field << 5);
+}
+
+constexpr uint8_t pressure_oversampling(uint8_t field)
+{
+    return static_cast<uint8_t>(field << 2);
 }
 
+static_assert(temperature_oversampling(4) == temperature_oversampling_8);
+static_assert(pressure_oversampling(4) == pressure_oversampling_8);
+} // namespace ControlMeasurement
+
 namespace Configuration
 {
 enum : uint8_t
@@ -107,6 +125,13 @@ enum : uint8_t
 
     enable_3wire_spi = 1
 };
+
+constexpr uint8_t filter_coefficient(uint8_t field)
+{
+    return static_cast<uint8_t>(field << 2);
+}
+
+static_assert(filter_coefficient(2) == filter_coefficient_4);
 } // namespace configuration
 
 namespace Status
@@ -118,20 +143,6 @@ enum : uint8_t
 };
 }
 
-union CallibrationDataSecondPart
-{
-    struct __attribute__((packed))
-    {
-        int16_t dig_H2;
-        uint8_t dig_H3;
-        uint8_t dig_H4_msb;
-        uint8_t dig_H4_lsb_H5_lsb;
-        uint8_t dig_H5_msb;
-        uint8_t dig_H6;
-    };
-    char mapped_region[7];
-};
-
 } // namespace BME280
 
 } // namespace jungles
@@ -0,0 +1,149 @@
+/**
+ * @file        test_aggregation.cpp
+ * @brief       Tests the streaming aggregation of BME280 measurements.
+ * @author      Kacper Kowalski - kacper.s.kowalski@gmail.com
+ */
+#include "catch2/catch_approx.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include "bme280_aggregation.hpp"
+
+#include <chrono>
+
+using namespace std::chrono_literals;
+
+TEST_CASE("BME280 measurements are decimated", "[bme280][aggregation]")
+{
+    jungles::BME280Decimator<4> decimator;
+
+    CHECK_FALSE(decimator.push({20.0, 100000.0, 40.0}));
+    CHECK_FALSE(decimator.push({21.0, 100002.0, 41.0}));
+    CHECK_FALSE(decimator.push({22.0, 100004.0, 42.0}));
+    auto result{decimator.push({23.0, 100006.0, 43.0})};
+
+    REQUIRE(result);
+    CHECK(result->temperature == Catch::Approx(21.5));
+    CHECK(result->pressure == Catch::Approx(100003.0));
+    CHECK(result->humidity == Catch::Approx(41.5));
+
+    SECTION("Decimator starts over after emitting a measurement")
+    {
+        CHECK_FALSE(decimator.push({20.0, 100000.0, 40.0}));
+    }
+}
+
+TEST_CASE("BME280 measurements are summarized in tumbling windows", "[bme280][aggregation]")
+{
+    SECTION("Floating point accumulation")
+    {
+        jungles::BME280TumblingWindow<4> window{1s};
+
+        CHECK_FALSE(window.push({20.0, 100000.0, 40.0}, 0ms));
+        CHECK_FALSE(window.push({22.0, 100010.0, 40.0}, 1000ms));
+        CHECK_FALSE(window.push({24.0, 100020.0, 40.0}, 2000ms));
+        auto summary{window.push({26.0, 100030.0, 40.0}, 3000ms)};
+
+        REQUIRE(summary);
+        CHECK(summary->begin == 0ms);
+        CHECK(summary->end == 3000ms);
+        CHECK(summary->sample_count == 4);
+        CHECK(summary->gap_count == 0);
+        CHECK(summary->temperature.min == Catch::Approx(20.0));
+        CHECK(summary->temperature.max == Catch::Approx(26.0));
+        CHECK(summary->temperature.mean == Catch::Approx(23.0));
+        CHECK(summary->temperature.variance == Catch::Approx(5.0));
+        CHECK(summary->pressure.mean == Catch::Approx(100015.0));
+        CHECK(summary->pressure.variance == Catch::Approx(125.0).epsilon(0.01));
+        CHECK(summary->humidity.variance == Catch::Approx(0.0).margin(1e-6));
+        CHECK_FALSE(window.flush());
+    }
+
+    SECTION("Fixed point accumulation")
+    {
+        jungles::BME280TumblingWindow<4, jungles::BME280FixedPointAccumulator<100>> window{1s};
+
+        window.push({20.0, 100000.0, 40.0}, 0ms);
+        window.push({22.0, 100010.0, 40.0}, 1000ms);
+        window.push({24.0, 100020.0, 40.0}, 2000ms);
+        auto summary{window.push({26.0, 100030.0, 40.0}, 3000ms)};
+
+        REQUIRE(summary);
+        CHECK(summary->temperature.min == Catch::Approx(20.0));
+        CHECK(summary->temperature.max == Catch::Approx(26.0));
+        CHECK(summary->temperature.mean == Catch::Approx(23.0));
+        CHECK(summary->temperature.variance == Catch::Approx(5.0));
+        CHECK(summary->pressure.mean == Catch::Approx(100015.0));
+        CHECK(summary->pressure.variance == Catch::Approx(125.0));
+    }
+
+    SECTION("Fixed point variance of a small spread is not truncated")
+    {
+        jungles::BME280TumblingWindow<3, jungles::BME280FixedPointAccumulator<100>> window{1s};
+
+        window.push({20.00, 100000.0, 40.0}, 0ms);
+        window.push({20.01, 100000.0, 40.0}, 1000ms);
+        auto summary{window.push({20.01, 100000.0, 40.0}, 2000ms)};
+
+        REQUIRE(summary);
+        CHECK(summary->temperature.variance == Catch::Approx(2.0e-4 / 9).epsilon(0.001));
+    }
+
+    SECTION("Gaps are counted and incomplete window is flushed")
+    {
+        jungles::BME280TumblingWindow<10> window{1s};
+
+        window.push({20.0, 100000.0, 40.0}, 0ms);
+        window.push({20.0, 100000.0, 40.0}, 1000ms);
+        window.push({20.0, 100000.0, 40.0}, 5000ms);
+        window.push({20.0, 100000.0, 40.0}, 9000ms);
+        auto summary{window.flush()};
+
+        REQUIRE(summary);
+        CHECK(summary->sample_count == 4);
+        CHECK(summary->gap_count == 2);
+        CHECK(summary->end == 9000ms);
+    }
+
+    SECTION("Gap between windows is not counted in any of them")
+    {
+        jungles::BME280TumblingWindow<2> window{1s};
+
+        window.push({20.0, 100000.0, 40.0}, 0ms);
+        window.push({20.0, 100000.0, 40.0}, 1000ms);
+        window.push({20.0, 100000.0, 40.0}, 9000ms);
+        auto summary{window.push({20.0, 100000.0, 40.0}, 10000ms)};
+
+        REQUIRE(summary);
+        CHECK(summary->begin == 9000ms);
+        CHECK(summary->gap_count == 0);
+    }
+}
+
+TEST_CASE("BME280 measurements are summarized in a sliding window", "[bme280][aggregation]")
+{
+    jungles::BME280SlidingWindow<3> window{1s};
+
+    CHECK_FALSE(window.summary());
+
+    window.push({20.0, 100000.0, 40.0}, 0ms);
+    window.push({21.0, 100000.0, 40.0}, 5000ms);
+    window.push({22.0, 100000.0, 40.0}, 6000ms);
+    auto summary{window.summary()};
+
+    REQUIRE(summary);
+    CHECK(summary->sample_count == 3);
+    CHECK(summary->gap_count == 1);
+    CHECK(summary->temperature.mean == Catch::Approx(21.0));
+
+    window.push({23.0, 100000.0, 40.0}, 7000ms);
+    summary = window.summary();
+
+    REQUIRE(summary);
+    CHECK(summary->begin == 5000ms);
+    CHECK(summary->end == 7000ms);
+    CHECK(summary->sample_count == 3);
+    CHECK(summary->gap_count == 0);
+    CHECK(summary->temperature.min == Catch::Approx(21.0));
+    CHECK(summary->temperature.max == Catch::Approx(23.0));
+    CHECK(summary->temperature.mean == Catch::Approx(22.0));
+}
@@ -121,3 +121,59 @@ TEST_CASE("BME280 measurements are converted", "[bme280]")
         // dig_H6 = 30; // 0x1e
     }
 }
+
+namespace
+{
+
+constexpr bool is_close(float value, float expected, float tolerance)
+{
+    auto difference{value - expected};
+    return difference <= tolerance && -difference <= tolerance;
+}
+
+constexpr jungles::BME280::CallibrationFirstPartBytes room_like_first_part{
+    0x32, 0x70, 0xd0, 0x68, 0x32, 0x00, 0x3a, 0x8e, 0x1b, 0xd6, 0xd0, 0x0b, 0x15,
+    0x24, 0x64, 0xff, 0xf9, 0xff, 0x0c, 0x30, 0x20, 0xd1, 0x88, 0x13, 0x00, 0x4b};
+
+constexpr auto room_like_parameters{
+    jungles::BME280::decode_compensation_parameters(room_like_first_part, {0x4c, 0x01, 0x00, 0x19, 0x20, 0x03, 0x1e})};
+
+static_assert(room_like_parameters.dig_T1 == 0x7032);
+static_assert(room_like_parameters.dig_P2 == static_cast<int16_t>(0xd61b));
+static_assert(room_like_parameters.dig_H4 == 0x190);
+static_assert(room_like_parameters.dig_H5 == 0x32);
+
+// dig_H4 and dig_H5 are signed: their most significant bytes (0xE4 and 0xE6) are sign-extended.
+constexpr auto negative_humidity_parameters{jungles::BME280::decode_compensation_parameters(
+    room_like_first_part, {0x4c, 0x01, 0x00, 0xf4, 0x3a, 0x81, 0x1e})};
+
+static_assert(negative_humidity_parameters.dig_H4 == -182);
+static_assert(negative_humidity_parameters.dig_H5 == -2029);
+
+constexpr auto room_like_measurement{
+    jungles::BME280::compensate(room_like_parameters, {0x4e, 0xba, 0xc0, 0x7f, 0xe3, 0x0, 0x8e, 0x1a})};
+
+static_assert(is_close(room_like_measurement.temperature, 20.56, 0.01));
+static_assert(is_close(room_like_measurement.pressure, 98456.1875, 1.0));
+static_assert(is_close(room_like_measurement.humidity, 54.42, 0.01));
+
+} // namespace
+
+TEST_CASE("BME280 measurements are converted at compile time", "[bme280]")
+{
+    SECTION("Positive test with room-like conditions with data from Internet")
+    {
+        constexpr auto parameters{jungles::BME280::decode_compensation_parameters(
+            {0xe6, 0x6e, 0xcf, 0x66, 0x32, 0x00, 0xfb, 0x90, 0x57, 0xd5, 0xd0, 0x0b, 0xea,
+             0x1a, 0x7b, 0xff, 0xf9, 0xff, 0xac, 0x26, 0x0a, 0xd8, 0xbd, 0x10, 0x00, 0x4b},
+            {0x66, 0x01, 0x00, 0x14, 0x0a, 0x00, 0x1e})};
+        constexpr auto measurement{
+            jungles::BME280::compensate(parameters, {0x51, 0xe9, 0x05, 0x7f, 0x92, 0x0b, 0x74, 0x15})};
+
+        STATIC_REQUIRE(parameters.dig_P8 == -10230);
+        STATIC_REQUIRE(parameters.dig_H4 == 330);
+        STATIC_REQUIRE(is_close(measurement.temperature, 21.43, 0.01));
+        STATIC_REQUIRE(is_close(measurement.pressure, 100819.0, 2.0));
+        STATIC_REQUIRE(is_close(measurement.humidity, 47.33, 0.01));
+    }
+}
@@ -0,0 +1,155 @@
+/**
+ * @file        test_derived_metrics.cpp
+ * @brief       Tests the quantities derived from BME280 measurements.
+ * @author      Kacper Kowalski - kacper.s.kowalski@gmail.com
+ */
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_approx.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include "bme280_derived_metrics.hpp"
+
+#include <cmath>
+#include <vector>
+
+using jungles::BME280DerivationMode;
+
+struct MeasurementSeries
+{
+    explicit MeasurementSeries(std::size_t size) :
+        temperature(size), pressure(size), humidity(size), altitude(size), dew_point(size), absolute_humidity(size),
+        specific_humidity(size)
+    {
+        // Spread the values over the whole operating range of BME280.
+        for (std::size_t i{0}; i < size; ++i)
+        {
+            temperature[i] = -40.0f + 125.0f * i / size;
+            pressure[i] = 30000.0f + 80000.0f * ((i * 7) % size) / size;
+            humidity[i] = 1.0f + 99.0f * ((i * 13) % size) / size;
+        }
+    }
+
+    jungles::BME280MeasurementSeries input() const
+    {
+        return {temperature.data(), pressure.data(), humidity.data(), temperature.size()};
+    }
+
+    jungles::BME280DerivedMetricsSeries output()
+    {
+        return {altitude.data(), dew_point.data(), absolute_humidity.data(), specific_humidity.data()};
+    }
+
+    std::vector<float> temperature, pressure, humidity;
+    std::vector<float> altitude, dew_point, absolute_humidity, specific_humidity;
+};
+
+TEST_CASE("Derived metrics are computed", "[bme280][derived]")
+{
+    SECTION("Reference values")
+    {
+        auto result{jungles::derive_metrics({20.0, 89874.6, 50.0}, 101325.0, BME280DerivationMode::reference)};
+        CHECK(result.altitude == Catch::Approx(1000.0).margin(0.5));
+        CHECK(result.dew_point == Catch::Approx(9.26).margin(0.01));
+        CHECK(result.absolute_humidity == Catch::Approx(8.62).margin(0.01));
+        CHECK(result.specific_humidity == Catch::Approx(8.11).margin(0.01));
+    }
+
+    SECTION("Altitude is zero at the sea level pressure")
+    {
+        auto result{jungles::derive_metrics({15.0, 100000.0, 50.0}, 100000.0)};
+        CHECK(result.altitude == Catch::Approx(0.0).margin(0.01));
+    }
+
+    SECTION("Dew point is defined for completely dry air")
+    {
+        auto result{jungles::derive_metrics({20.0, 101325.0, 0.0})};
+        CHECK(std::isfinite(result.dew_point));
+        CHECK(result.dew_point < -60.0);
+    }
+
+    SECTION("NaN humidity is treated as completely dry air in both modes")
+    {
+        jungles::BME280Measurement measurement{20.0, 101325.0, std::nanf("")};
+        auto dry_air{jungles::derive_metrics({20.0, 101325.0, 0.0})};
+
+        for (auto mode : {BME280DerivationMode::fast, BME280DerivationMode::reference})
+        {
+            auto result{jungles::derive_metrics(measurement, jungles::standard_sea_level_pressure, mode)};
+            CHECK(result.dew_point == Catch::Approx(dry_air.dew_point).margin(0.001));
+        }
+    }
+
+    SECTION("Fast mode is within the documented error bounds")
+    {
+        MeasurementSeries series{4096};
+        for (std::size_t i{0}; i < series.temperature.size(); ++i)
+        {
+            jungles::BME280Measurement m{series.temperature[i], series.pressure[i], series.humidity[i]};
+            auto fast{jungles::derive_metrics(m, jungles::standard_sea_level_pressure, BME280DerivationMode::fast)};
+            auto reference{
+                jungles::derive_metrics(m, jungles::standard_sea_level_pressure, BME280DerivationMode::reference)};
+
+            CHECK(fast.altitude == Catch::Approx(reference.altitude).margin(0.01));
+            CHECK(fast.dew_point == Catch::Approx(reference.dew_point).margin(0.001));
+            CHECK(fast.absolute_humidity == Catch::Approx(reference.absolute_humidity).margin(0.001));
+            CHECK(fast.specific_humidity == Catch::Approx(reference.specific_humidity).epsilon(0.00001));
+        }
+    }
+
+    SECTION("Batch results are the same as the single sample ones")
+    {
+        MeasurementSeries series{100};
+        jungles::derive_metrics(
+            series.input(), series.output(), jungles::standard_sea_level_pressure, BME280DerivationMode::fast);
+
+        for (std::size_t i{0}; i < series.temperature.size(); ++i)
+        {
+            jungles::BME280Measurement m{series.temperature[i], series.pressure[i], series.humidity[i]};
+            auto single{jungles::derive_metrics(m, jungles::standard_sea_level_pressure, BME280DerivationMode::fast)};
+            CHECK(series.altitude[i] == Catch::Approx(single.altitude));
+            CHECK(series.dew_point[i] == Catch::Approx(single.dew_point));
+            CHECK(series.absolute_humidity[i] == Catch::Approx(single.absolute_humidity));
+            CHECK(series.specific_humidity[i] == Catch::Approx(single.specific_humidity));
+        }
+    }
+}
+
+// Hidden from the default run. Invoke the test executable with "[benchmark]" to run it.
+TEST_CASE("Derived metrics benchmark", "[.][benchmark]")
+{
+    MeasurementSeries series{65536};
+
+    auto derive_one_by_one{[&](BME280DerivationMode mode) {
+        float sum{0};
+        for (std::size_t i{0}; i < series.temperature.size(); ++i)
+            sum += jungles::derive_metrics({series.temperature[i], series.pressure[i], series.humidity[i]},
+                                           jungles::standard_sea_level_pressure,
+                                           mode)
+                       .dew_point;
+        return sum;
+    }};
+
+    BENCHMARK("Batch, fast mode")
+    {
+        jungles::derive_metrics(
+            series.input(), series.output(), jungles::standard_sea_level_pressure, BME280DerivationMode::fast);
+        return series.altitude.back();
+    };
+
+    BENCHMARK("Batch, reference mode")
+    {
+        jungles::derive_metrics(
+            series.input(), series.output(), jungles::standard_sea_level_pressure, BME280DerivationMode::reference);
+        return series.altitude.back();
+    };
+
+    BENCHMARK("Single measurement, fast mode")
+    {
+        return derive_one_by_one(BME280DerivationMode::fast);
+    };
+
+    BENCHMARK("Single measurement, reference mode")
+    {
+        return derive_one_by_one(BME280DerivationMode::reference);
+    };
+}
@@ -0,0 +1,208 @@
+/**
+ * @file        test_oversampling.cpp
+ * @brief       Tests configuration of oversampling and the adaptive oversampling controller.
+ * @author      Kacper Kowalski - kacper.s.kowalski@gmail.com
+ */
+#include "catch2/catch_test_macros.hpp"
+
+#include "bme280_driver.hpp"
+#include "bme280_oversampling_controller.hpp"
+
+#include <cmath>
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace std::chrono_literals;
+using jungles::BME280Filter;
+using jungles::BME280Oversampling;
+using jungles::BME280Settings;
+
+struct I2CMasterRecordingMock : jungles::I2CMaster
+{
+    virtual Bytes read(unsigned char, unsigned char, unsigned num_bytes) override
+    {
+        return Bytes(num_bytes);
+    }
+
+    virtual unsigned char read_byte(unsigned char, unsigned char register_address) override
+    {
+        if (register_address == 0xD0)
+            return 0x60;
+        return registers[register_address];
+    }
+
+    virtual void write(unsigned char, unsigned char, std::string_view) override
+    {
+    }
+
+    virtual void write_byte(unsigned char, unsigned char register_address, unsigned char byte) override
+    {
+        registers[register_address] = byte;
+    }
+
+    std::map<unsigned char, unsigned char> registers;
+};
+
+TEST_CASE("BME280 oversampling and filter are configured", "[bme280][oversampling]")
+{
+    I2CMasterRecordingMock i2c_master_mock;
+    std::vector<std::chrono::milliseconds> delays;
+
+    SECTION("Defaults to x8 oversampling without filter")
+    {
+        jungles::BME280Driver bme280_driver{i2c_master_mock, [](auto) {
+                                            }};
+        CHECK(i2c_master_mock.registers[0xF2] == 0b100);
+        CHECK(i2c_master_mock.registers[0xF4] == 0b10010000);
+        CHECK(i2c_master_mock.registers[0xF5] == 0);
+        CHECK(bme280_driver.measurement_time() == 57600us);
+    }
+
+    SECTION("Reconfiguration is applied to the registers")
+    {
+        jungles::BME280Driver bme280_driver{i2c_master_mock, [&](auto delay) {
+                                                delays.push_back(delay);
+                                            }};
+        BME280Settings settings{BME280Oversampling::x1, BME280Oversampling::x16, BME280Oversampling::x2,
+                                BME280Filter::coefficient_4};
+        bme280_driver.configure(settings);
+
+        CHECK(i2c_master_mock.registers[0xF2] == 0b010);
+        CHECK(i2c_master_mock.registers[0xF4] == 0b00110100);
+        CHECK(i2c_master_mock.registers[0xF5] == 0b01000);
+        CHECK(bme280_driver.settings() == settings);
+        CHECK(bme280_driver.measurement_time() == 46100us);
+
+        delays.clear();
+        bme280_driver.read();
+        REQUIRE_FALSE(delays.empty());
+        CHECK(delays.front() == 47ms);
+    }
+}
+
+TEST_CASE("BME280 oversampling adapts to the noise", "[bme280][oversampling]")
+{
+    jungles::BME280OversamplingController::Config config;
+    config.estimation_samples = 4;
+    config.confirmations = 1;
+    jungles::BME280OversamplingController controller{BME280Settings{}, config};
+
+    auto feed{[&](unsigned count, float pressure_noise) {
+        std::optional<BME280Settings> result;
+        for (unsigned i{0}; i < count && !result; ++i)
+        {
+            auto sign{i % 2 == 0 ? 1.0f : -1.0f};
+            result = controller.update({20.0, 100000.0f + sign * pressure_noise, 50.0});
+        }
+        return result;
+    }};
+
+    SECTION("Oversampling is decreased for a stable signal, but not before the noise is estimated")
+    {
+        CHECK_FALSE(feed(4, 0.0));
+        auto new_settings{feed(1, 0.0)};
+
+        REQUIRE(new_settings);
+        CHECK(new_settings->temperature_oversampling == BME280Oversampling::x4);
+        CHECK(new_settings->pressure_oversampling == BME280Oversampling::x4);
+        CHECK(new_settings->humidity_oversampling == BME280Oversampling::x4);
+        CHECK(controller.settings() == *new_settings);
+        CHECK(controller.measurement_time() == jungles::measurement_time(*new_settings));
+    }
+
+    SECTION("Noisy pressure increases pressure oversampling and then the filter")
+    {
+        auto new_settings{feed(5, 5.0)};
+        REQUIRE(new_settings);
+        CHECK(new_settings->pressure_oversampling == BME280Oversampling::x16);
+
+        new_settings = feed(5, 5.0);
+        REQUIRE(new_settings);
+        CHECK(new_settings->pressure_oversampling == BME280Oversampling::x16);
+        CHECK(new_settings->filter == BME280Filter::coefficient_2);
+    }
+
+    SECTION("Settings are changed only after the same decision is made for consecutive blocks")
+    {
+        config.confirmations = 2;
+        controller = jungles::BME280OversamplingController{BME280Settings{}, config};
+
+        CHECK_FALSE(feed(5, 0.0));
+        CHECK(feed(5, 0.0));
+    }
+
+    SECTION("Measurement time does not exceed the latency budget")
+    {
+        config.max_measurement_time = 60ms;
+        config.pressure_noise = 0;
+        config.humidity_noise = 0;
+        jungles::BME280OversamplingController latency_bound_controller{
+            BME280Settings{BME280Oversampling::x8, BME280Oversampling::x8, BME280Oversampling::x8}, config};
+
+        std::optional<BME280Settings> new_settings;
+        for (unsigned i{0}; i < 5; ++i)
+            new_settings = latency_bound_controller.update({20.0f + (i % 2) * 1.0f, 100000.0, 50.0});
+
+        CHECK_FALSE(new_settings);
+        CHECK(latency_bound_controller.measurement_time() <= 60ms);
+    }
+
+    SECTION("Initial settings are lowered to the latency budget and reported by the first update")
+    {
+        config.max_measurement_time = 20ms;
+        jungles::BME280OversamplingController latency_bound_controller{BME280Settings{}, config};
+
+        CHECK(latency_bound_controller.measurement_time() <= 20ms);
+        CHECK(latency_bound_controller.settings().pressure_oversampling == BME280Oversampling::x2);
+
+        auto new_settings{latency_bound_controller.update({20.0, 100000.0, 50.0})};
+        REQUIRE(new_settings);
+        CHECK(*new_settings == latency_bound_controller.settings());
+        CHECK_FALSE(latency_bound_controller.update({20.0, 100000.0, 50.0}));
+    }
+
+    SECTION("Initial settings within the latency budget are not reported")
+    {
+        jungles::BME280OversamplingController latency_bound_controller{BME280Settings{}, config};
+
+        CHECK(latency_bound_controller.settings() == BME280Settings{});
+        CHECK_FALSE(latency_bound_controller.update({20.0, 100000.0, 50.0}));
+    }
+}
+
+TEST_CASE("BME280 oversampling settles on a noisy signal", "[bme280][oversampling]")
+{
+    // Simulates white noise, which decreases with the square root of the oversampling, and the IIR filter of BME280.
+    std::mt19937 generator{1};
+    std::normal_distribution<float> normal;
+    auto noisy{[&](float noise_at_x1, BME280Oversampling oversampling) {
+        return noise_at_x1 / std::sqrt(static_cast<float>(jungles::to_sample_count(oversampling))) * normal(generator);
+    }};
+
+    for (auto pressure_noise_at_x1 : {2.0f, 5.0f, 10.0f, 30.0f})
+    {
+        jungles::BME280OversamplingController controller{BME280Settings{}};
+        auto settings{controller.settings()};
+        float temperature{20.0};
+        float pressure{100000.0};
+        unsigned number_of_changes{0};
+
+        for (unsigned i{0}; i < 3000; ++i)
+        {
+            auto filter_coefficient{static_cast<float>(1u << static_cast<unsigned>(settings.filter))};
+            temperature += (20.0f + noisy(0.02, settings.temperature_oversampling) - temperature) / filter_coefficient;
+            pressure += (100000.0f + noisy(pressure_noise_at_x1, settings.pressure_oversampling) - pressure)
+                        / filter_coefficient;
+            auto humidity{50.0f + noisy(0.05, settings.humidity_oversampling)};
+
+            if (auto new_settings{controller.update({temperature, pressure, humidity})}; new_settings)
+            {
+                settings = *new_settings;
+                ++number_of_changes;
+            }
+        }
+
+        CHECK(number_of_changes <= 10);
+    }
+}